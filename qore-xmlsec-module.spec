@@ -34,7 +34,7 @@
 
 Summary: XML Security Module for Qore
 Name: qore-xmlsec-module
-Version: 1.0.0
+Version: 1.1.0
 Release: 1%{dist}
 License: LGPL
 Group: Development/Languages
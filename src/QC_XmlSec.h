@@ -32,6 +32,14 @@ DLLLOCAL int q_xmlsec_verify(ExceptionSink* xsink, const QoreStringNode* signed_
 DLLLOCAL int q_xmlsec_verify(ExceptionSink* xsink, const QoreStringNode* signed_string, QoreXmlSecKey* key,
         unsigned offset = 0, const QoreListNode* args = nullptr);
 
+DLLLOCAL QoreStringNode* q_xmlsec_encrypt(ExceptionSink* xsink, const QoreStringNode* str_data,
+        const QoreStringNode* tmpl, QoreXmlSecKey* key, QoreXmlSecKeyManager* key_manager);
+DLLLOCAL QoreStringNode* q_xmlsec_encrypt(ExceptionSink* xsink, const BinaryNode* bin_data,
+        const QoreStringNode* tmpl, QoreXmlSecKey* key, QoreXmlSecKeyManager* key_manager);
+DLLLOCAL QoreValue q_xmlsec_decrypt(ExceptionSink* xsink, const QoreStringNode* xml, QoreXmlSecKey* key);
+DLLLOCAL QoreValue q_xmlsec_decrypt(ExceptionSink* xsink, const QoreStringNode* xml, QoreXmlSecKeyManager* key_manager);
+DLLLOCAL QoreStringNode* q_xmlsec_sign(ExceptionSink* xsink, const QoreStringNode* tmpl, QoreXmlSecKey* key);
+
 DLLLOCAL extern qore_classid_t CID_XMLSEC;
 DLLLOCAL extern QoreClass* QC_XMLSEC;
 
@@ -0,0 +1,130 @@
+/*
+    QC_XmlSecAsyncResult.h
+
+    Qore Programming Language
+
+    Copyright 2003 - 2021 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_XMLSECASYNCRESULT_H
+
+#define _QORE_XMLSECASYNCRESULT_H
+
+#include <chrono>
+
+DLLLOCAL extern qore_classid_t CID_XMLSECASYNCRESULT;
+DLLLOCAL extern QoreClass* QC_XMLSECASYNCRESULT;
+
+DLLLOCAL QoreClass* initXmlSecAsyncResultClass(QoreNamespace& ns);
+
+//! the result of an asynchronous xmlsec operation; set once by a worker thread
+class QoreXmlSecAsyncResult : public AbstractPrivateData, public QoreThreadLock {
+public:
+    DLLLOCAL QoreXmlSecAsyncResult() {
+    }
+
+    DLLLOCAL virtual void deref(ExceptionSink* xsink) {
+        if (ROdereference()) {
+            result.discard(xsink);
+            arg.discard(xsink);
+            // discard any exception that was never retrieved
+            op_xsink.clear();
+            delete this;
+        }
+    }
+
+    DLLLOCAL bool isDone() {
+        AutoLocker al(this);
+        return done;
+    }
+
+    //! waits for the operation to complete; timeout_ms <= 0 means wait indefinitely
+    /** returns the result of the operation or raises the exception raised by the operation
+    */
+    DLLLOCAL QoreValue wait(ExceptionSink* xsink, int64 timeout_ms) {
+        std::chrono::steady_clock::time_point deadline;
+        if (timeout_ms > 0) {
+            deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        }
+
+        AutoLocker al(this);
+        while (!done) {
+            if (timeout_ms > 0) {
+                // only wait for the time remaining until the deadline, rounded up to the next millisecond
+                int64 remaining_us = std::chrono::duration_cast<std::chrono::microseconds>(deadline
+                    - std::chrono::steady_clock::now()).count();
+                if (remaining_us <= 0 || (cond.wait(this, (remaining_us + 999) / 1000) && !done)) {
+                    xsink->raiseException("XMLSEC-ASYNC-TIMEOUT-ERROR", "timeout waiting " QLLD " ms for the "
+                        "asynchronous operation to complete", timeout_ms);
+                    return QoreValue();
+                }
+            } else {
+                cond.wait(this);
+            }
+        }
+
+        if (err) {
+            if (op_xsink) {
+                // the first call gets the original exception with its location and call stack
+                xsink->assimilate(op_xsink);
+            } else {
+                xsink->raiseExceptionArg(err->c_str(), arg.refSelf(), desc ? desc->stringRefSelf()
+                    : new QoreStringNode);
+            }
+            return QoreValue();
+        }
+
+        return result.refSelf();
+    }
+
+    //! sets the result of the operation and wakes up any waiting threads; takes over ownership of the value
+    /** if the operation raised an exception, the exception is taken from \a xsink
+    */
+    DLLLOCAL void setResult(QoreValue val, ExceptionSink& xsink) {
+        AutoLocker al(this);
+        assert(!done);
+        if (xsink) {
+            QoreStringValueHelper e(xsink.getExceptionErr());
+            err = new QoreStringNode(e->c_str());
+            QoreValue d = xsink.getExceptionDesc();
+            if (d.getType() == NT_STRING) {
+                desc = d.get<QoreStringNode>()->stringRefSelf();
+            }
+            arg = xsink.getExceptionArg().refSelf();
+            op_xsink.assimilate(xsink);
+            // results are always strings or binary values
+            val.discard(nullptr);
+        } else {
+            result = val;
+        }
+        done = true;
+        cond.broadcast();
+    }
+
+private:
+    QoreCondition cond;
+    bool done = false;
+    QoreValue result;
+    // the exception raised by the operation until retrieved by the first call to wait()
+    ExceptionSink op_xsink;
+    // the exception raised by the operation, if any, for subsequent calls to wait()
+    SimpleRefHolder<QoreStringNode> err;
+    SimpleRefHolder<QoreStringNode> desc;
+    QoreValue arg;
+};
+
+#endif
@@ -24,6 +24,9 @@
 
 #define _QORE_XMLSECKEY_H
 
+#include "QoreXmlSecKeyCache.h"
+#include "QoreXmlSecVerifyCache.h"
+
 DLLLOCAL extern qore_classid_t CID_XMLSECKEY;
 DLLLOCAL extern QoreClass* QC_XMLSECKEY;
 
@@ -33,11 +36,16 @@ class QoreXmlSecKey : public AbstractPrivateData, public QoreThreadLock {
 public:
     DLLLOCAL QoreXmlSecKey(ExceptionSink* xsink, xmlSecByte* ptr, int len, xmlSecKeyDataFormat format,
             const char* password = nullptr) {
+        key = key_cache.get(ptr, len, format, password);
+        if (key) {
+            return;
+        }
         key = xmlSecCryptoAppKeyLoadMemory(ptr, len, format, password, 0, 0);
         if (!key) {
             xsink->raiseException("XMLSECKEY-ERROR", "key creation from memory buffer failed");
             return;
         }
+        key_cache.add(ptr, len, format, password, key);
     }
 
     DLLLOCAL QoreXmlSecKey(const xmlChar* name, xmlSecSize sizeBits, xmlSecKeyDataType type,
@@ -65,6 +73,7 @@ public:
     }
 
     DLLLOCAL xmlSecKeyPtr clone(ExceptionSink* xsink) {
+        AutoLocker al(this);
         xmlSecKeyPtr k = xmlSecKeyDuplicate(key);
         if (!k) {
             xsink->raiseException("XMLSECKEY-ERROR", "failed to copy key");
@@ -74,6 +83,7 @@ public:
     }
 
     DLLLOCAL QoreXmlSecKey* copy(ExceptionSink* xsink) {
+        AutoLocker al(this);
         xmlSecKeyPtr k = xmlSecKeyDuplicate(key);
         if (!k) {
             xsink->raiseException("XMLSECKEY-ERROR", "failed to copy key");
@@ -95,6 +105,7 @@ public:
             xsink->raiseException("XMLSECKEY-ERROR", "failed to add certificate");
             return -1;
         }
+        verify_cache.clear();
         return 0;
     }
 
@@ -108,6 +119,7 @@ public:
             xsink->raiseException("XMLSECKEY-ERROR","failed to set key name '%s'", name);
             return -1;
         }
+        verify_cache.clear();
         return 0;
     }
 
@@ -143,8 +155,14 @@ public:
         return isValidIntern();
     }
 
+    DLLLOCAL QoreXmlSecVerifyCache& getVerifyCache() {
+        return verify_cache;
+    }
+
 private:
     xmlSecKeyPtr key;
+    // cache of successfully-verified inputs; cleared when the key changes
+    QoreXmlSecVerifyCache verify_cache;
 
     // not implemented
     QoreXmlSecKey(const QoreXmlSecKey& k) = delete;
@@ -24,6 +24,8 @@
 
 #define _QORE_XMLSECKEYMANAGER_H
 
+#include "QoreXmlSecVerifyCache.h"
+
 DLLLOCAL extern qore_classid_t CID_XMLSECKEYMANAGER;
 DLLLOCAL extern QoreClass* QC_XMLSECKEYMANAGER;
 
@@ -32,6 +34,8 @@ DLLLOCAL QoreClass* initXmlSecKeyManagerClass(QoreNamespace& ns);
 class QoreXmlSecKeyManager : public AbstractPrivateData, public QoreThreadLock {
 private:
     xmlSecKeysMngrPtr keyMgr;
+    // cache of successfully-verified inputs; cleared when keys or certificates are added
+    QoreXmlSecVerifyCache verify_cache;
 
 public:
     DLLLOCAL QoreXmlSecKeyManager(ExceptionSink* xsink) : keyMgr(xmlSecKeysMngrCreate()) {
@@ -63,6 +67,7 @@ public:
             return -1;
         }
 
+        verify_cache.clear();
         return 0;
     }
 
@@ -76,6 +81,7 @@ public:
             return -1;
         }
 
+        verify_cache.clear();
         return 0;
     }
 
@@ -90,6 +96,7 @@ public:
             return -1;
         }
 
+        verify_cache.clear();
         return 0;
     }
 
@@ -100,6 +107,10 @@ public:
     DLLLOCAL xmlSecKeysMngrPtr getKeyManager() {
         return keyMgr;
     }
+
+    DLLLOCAL QoreXmlSecVerifyCache& getVerifyCache() {
+        return verify_cache;
+    }
 };
 
 #endif
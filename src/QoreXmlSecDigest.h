@@ -0,0 +1,76 @@
+/*
+    Qore Programming Language
+
+    Copyright 2003 - 2021 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_XMLSEC_QOREXMLSECDIGEST_H
+
+#define _QORE_XMLSEC_QOREXMLSECDIGEST_H
+
+#include <openssl/evp.h>
+
+#include <string>
+
+//! incremental SHA-256 digest used to create cache keys
+class QoreXmlSecDigest {
+public:
+    DLLLOCAL QoreXmlSecDigest() : ctx(EVP_MD_CTX_create()) {
+        if (ctx && !EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr)) {
+            EVP_MD_CTX_destroy(ctx);
+            ctx = nullptr;
+        }
+    }
+
+    DLLLOCAL ~QoreXmlSecDigest() {
+        if (ctx) {
+            EVP_MD_CTX_destroy(ctx);
+        }
+    }
+
+    DLLLOCAL operator bool() const {
+        return (bool)ctx;
+    }
+
+    DLLLOCAL void update(const void* ptr, size_t len) {
+        EVP_DigestUpdate(ctx, ptr, len);
+    }
+
+    //! adds the length of the data before the data itself so that consecutive fields cannot be confused
+    DLLLOCAL void updateField(const void* ptr, size_t len) {
+        update(&len, sizeof(len));
+        update(ptr, len);
+    }
+
+    //! returns the binary digest; returns an empty string on error
+    DLLLOCAL std::string get() {
+        unsigned char md[EVP_MAX_MD_SIZE];
+        unsigned len = 0;
+        if (!EVP_DigestFinal_ex(ctx, md, &len)) {
+            return std::string();
+        }
+        return std::string((const char*)md, len);
+    }
+
+private:
+    EVP_MD_CTX* ctx;
+
+    // not implemented
+    QoreXmlSecDigest(const QoreXmlSecDigest&) = delete;
+};
+
+#endif
@@ -0,0 +1,116 @@
+/*
+    Qore Programming Language
+
+    Copyright 2003 - 2021 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_XMLSEC_QOREXMLSECKEYCACHE_H
+
+#define _QORE_XMLSEC_QOREXMLSECKEYCACHE_H
+
+#include "QoreXmlSecLruCache.h"
+
+//! caches keys loaded from memory so that identical key data is only decoded once
+/** the cache is disabled by default (max size 0); cached keys are never handed out directly, callers always get a
+    copy that they own.  Entries are keyed by a SHA-256 digest of the key data, format, and password, so neither the
+    key data nor the password is retained.
+*/
+class QoreXmlSecKeyCache : public QoreXmlSecLruCache<xmlSecKeyPtr> {
+public:
+    DLLLOCAL ~QoreXmlSecKeyCache() {
+        clear();
+    }
+
+    //! returns a copy of the cached key or nullptr if not cached
+    DLLLOCAL xmlSecKeyPtr get(const xmlSecByte* ptr, size_t len, xmlSecKeyDataFormat format, const char* password) {
+        // avoid locking when the cache is disabled
+        if (!enabled()) {
+            return nullptr;
+        }
+
+        std::string ckey = getCacheKey(ptr, len, format, password);
+        if (ckey.empty()) {
+            return nullptr;
+        }
+
+        AutoLocker al(this);
+        xmlSecKeyPtr* k = findIntern(ckey);
+        return k ? xmlSecKeyDuplicate(*k) : nullptr;
+    }
+
+    //! adds a copy of the given key to the cache
+    DLLLOCAL void add(const xmlSecByte* ptr, size_t len, xmlSecKeyDataFormat format, const char* password,
+            xmlSecKeyPtr key) {
+        if (!enabled()) {
+            return;
+        }
+
+        std::string ckey = getCacheKey(ptr, len, format, password);
+        if (ckey.empty()) {
+            return;
+        }
+
+        xmlSecKeyPtr k = xmlSecKeyDuplicate(key);
+        if (!k) {
+            return;
+        }
+
+        AutoLocker al(this);
+        if (!addIntern(std::move(ckey), k)) {
+            xmlSecKeyDestroy(k);
+        }
+    }
+
+    //! sets the maximum number of entries and the expiry time in milliseconds (0 = no expiry)
+    DLLLOCAL void setOptions(size_t size, int64 expiry) {
+        AutoLocker al(this);
+        setOptionsIntern(size, expiry);
+    }
+
+    DLLLOCAL void clear() {
+        AutoLocker al(this);
+        clearIntern();
+    }
+
+protected:
+    DLLLOCAL virtual void freeValue(xmlSecKeyPtr& key) {
+        xmlSecKeyDestroy(key);
+    }
+
+private:
+    //! returns the SHA-256 digest of the inputs or an empty string on error
+    DLLLOCAL static std::string getCacheKey(const xmlSecByte* ptr, size_t len, xmlSecKeyDataFormat format,
+            const char* password) {
+        QoreXmlSecDigest digest;
+        if (!digest) {
+            return std::string();
+        }
+        digest.update(&format, sizeof(format));
+        if (password) {
+            digest.update("\1", 1);
+            digest.updateField(password, strlen(password));
+        } else {
+            digest.update("\0", 1);
+        }
+        digest.updateField(ptr, len);
+        return digest.get();
+    }
+};
+
+DLLLOCAL extern QoreXmlSecKeyCache key_cache;
+
+#endif
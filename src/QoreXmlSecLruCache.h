@@ -0,0 +1,159 @@
+/*
+    Qore Programming Language
+
+    Copyright 2003 - 2021 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_XMLSEC_QOREXMLSECLRUCACHE_H
+
+#define _QORE_XMLSEC_QOREXMLSECLRUCACHE_H
+
+#include "QoreXmlSecDigest.h"
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+//! bounded LRU cache with optional expiry keyed by binary digests
+/** the cache is disabled by default (max size 0); subclasses provide locking around the *Intern() methods and
+    override freeValue() if values own resources
+*/
+template <typename T>
+class QoreXmlSecLruCache : public QoreThreadLock {
+public:
+    // subclasses that override freeValue() must call clearIntern() in their destructors
+    DLLLOCAL virtual ~QoreXmlSecLruCache() {
+    }
+
+    //! can be called without the lock
+    DLLLOCAL bool enabled() const {
+        return (bool)max_size.load(std::memory_order_relaxed);
+    }
+
+    DLLLOCAL QoreHashNode* getInfo() {
+        AutoLocker al(this);
+        QoreHashNode* h = new QoreHashNode(autoTypeInfo);
+        h->setKeyValue("max_size", (int64)max_size.load(), nullptr);
+        h->setKeyValue("expiry", expiry_ms, nullptr);
+        h->setKeyValue("size", (int64)cache.size(), nullptr);
+        h->setKeyValue("hits", hits, nullptr);
+        h->setKeyValue("misses", misses, nullptr);
+        return h;
+    }
+
+protected:
+    //! frees a value removed from the cache
+    DLLLOCAL virtual void freeValue(T& val) {
+    }
+
+    //! returns the cached value or nullptr if not present or expired; must be called with the lock held
+    DLLLOCAL T* findIntern(const std::string& ckey) {
+        typename cache_t::iterator i = cache.find(ckey);
+        if (i == cache.end()) {
+            ++misses;
+            return nullptr;
+        }
+
+        // the current expiry applies to all entries, including those added before it was set
+        if (expiry_ms && std::chrono::steady_clock::now() - i->second.inserted
+            >= std::chrono::milliseconds(expiry_ms)) {
+            removeIntern(i);
+            ++misses;
+            return nullptr;
+        }
+
+        // move to the front of the LRU list
+        lru.splice(lru.begin(), lru, i->second.lru_pos);
+        ++hits;
+        return &i->second.val;
+    }
+
+    //! adds the value; returns false if the value was not added, in which case the caller still owns it
+    /** must be called with the lock held
+    */
+    DLLLOCAL bool addIntern(std::string&& ckey, T val) {
+        if (!max_size.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        std::pair<typename cache_t::iterator, bool> r = cache.insert(typename cache_t::value_type(std::move(ckey),
+            entry_t()));
+        if (!r.second) {
+            return false;
+        }
+        lru.push_front(&r.first->first);
+        r.first->second.val = val;
+        r.first->second.lru_pos = lru.begin();
+        r.first->second.inserted = std::chrono::steady_clock::now();
+
+        trimIntern();
+        return true;
+    }
+
+    //! sets the maximum number of entries and the expiry time in milliseconds (0 = no expiry)
+    /** must be called with the lock held
+    */
+    DLLLOCAL void setOptionsIntern(size_t size, int64 expiry) {
+        max_size = size;
+        expiry_ms = expiry > 0 ? expiry : 0;
+        trimIntern();
+    }
+
+    //! must be called with the lock held
+    DLLLOCAL void clearIntern() {
+        for (auto& i : cache) {
+            freeValue(i.second.val);
+        }
+        cache.clear();
+        lru.clear();
+    }
+
+private:
+    typedef std::list<const std::string*> lru_t;
+
+    struct entry_t {
+        T val;
+        lru_t::iterator lru_pos;
+        std::chrono::steady_clock::time_point inserted;
+    };
+
+    typedef std::unordered_map<std::string, entry_t> cache_t;
+
+    cache_t cache;
+    // most recently used entries at the front
+    lru_t lru;
+    std::atomic<size_t> max_size{0};
+    int64 expiry_ms = 0;
+    int64 hits = 0;
+    int64 misses = 0;
+
+    DLLLOCAL void removeIntern(typename cache_t::iterator i) {
+        freeValue(i->second.val);
+        lru.erase(i->second.lru_pos);
+        cache.erase(i);
+    }
+
+    DLLLOCAL void trimIntern() {
+        while (cache.size() > max_size.load(std::memory_order_relaxed)) {
+            removeIntern(cache.find(*lru.back()));
+        }
+    }
+};
+
+#endif
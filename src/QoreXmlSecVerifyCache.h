@@ -0,0 +1,69 @@
+/*
+    Qore Programming Language
+
+    Copyright 2003 - 2021 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_XMLSEC_QOREXMLSECVERIFYCACHE_H
+
+#define _QORE_XMLSEC_QOREXMLSECVERIFYCACHE_H
+
+#include "QoreXmlSecLruCache.h"
+
+//! bounded LRU cache of successfully-verified signed XML inputs for a key or key manager
+/** the cache is disabled by default (max size 0); entries are keyed by a SHA-256 digest of the verification options
+    and the input string.  All entries are invalidated when the keys used for verification change, and entries can
+    be given an expiry time so that certificate validity is checked again periodically.
+*/
+class QoreXmlSecVerifyCache : public QoreXmlSecLruCache<bool> {
+public:
+    //! returns true if the input has already been verified; otherwise sets the generation for a later call to add()
+    DLLLOCAL bool check(const std::string& ckey, int64& gen) {
+        AutoLocker al(this);
+        if (findIntern(ckey)) {
+            return true;
+        }
+        gen = generation;
+        return false;
+    }
+
+    //! adds a successfully-verified input; ignored if the keys have changed since check() was called
+    DLLLOCAL void add(std::string&& ckey, int64 gen) {
+        AutoLocker al(this);
+        if (gen == generation) {
+            addIntern(std::move(ckey), true);
+        }
+    }
+
+    //! sets the maximum number of entries and the expiry time in milliseconds (0 = no expiry)
+    DLLLOCAL void setOptions(size_t size, int64 expiry) {
+        AutoLocker al(this);
+        setOptionsIntern(size, expiry);
+    }
+
+    //! removes all entries; called when the keys used for verification change
+    DLLLOCAL void clear() {
+        AutoLocker al(this);
+        ++generation;
+        clearIntern();
+    }
+
+private:
+    int64 generation = 0;
+};
+
+#endif
@@ -0,0 +1,234 @@
+/*
+    Qore Programming Language
+
+    Copyright 2003 - 2021 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "qore-xmlsec.h"
+
+#include "QoreXmlSecWorkerPool.h"
+
+#include <thread>
+
+QoreValue QoreXmlSecAsyncTask::exec(ExceptionSink* xsink) {
+    switch (op) {
+        case OP_SIGN:
+            return q_xmlsec_sign(xsink, *tmpl, *key);
+
+        case OP_VERIFY:
+            if (mgr) {
+                q_xmlsec_verify(xsink, *str, *mgr, 0, ids);
+            } else {
+                q_xmlsec_verify(xsink, *str, *key, 0, ids);
+            }
+            return QoreValue();
+
+        case OP_ENCRYPT:
+            if (bin) {
+                return q_xmlsec_encrypt(xsink, *bin, *tmpl, *key, *mgr);
+            }
+            return q_xmlsec_encrypt(xsink, *str, *tmpl, *key, *mgr);
+
+        case OP_DECRYPT:
+            if (mgr) {
+                return q_xmlsec_decrypt(xsink, *str, *mgr);
+            }
+            return q_xmlsec_decrypt(xsink, *str, *key);
+    }
+
+    assert(false);
+    return QoreValue();
+}
+
+bool QoreXmlSecAsyncTask::run() {
+    ExceptionSink xsink;
+    bool call = false;
+    {
+        // fails if the program is being deleted
+        QoreExternalProgramContextHelper pch(&xsink, pgm);
+        if (xsink) {
+            res->setResult(QoreValue(), xsink);
+        } else {
+            ExceptionSink op_xsink;
+            QoreValue rv = exec(&op_xsink);
+            res->setResult(rv, op_xsink);
+            call = (bool)callback;
+        }
+        if (!call) {
+            cleanup(&xsink);
+        }
+    }
+    if (xsink) {
+        xsink.handleExceptions();
+    }
+    return call;
+}
+
+void QoreXmlSecAsyncTask::runCallback() {
+    ExceptionSink xsink;
+    {
+        // fails if the program has been deleted since the operation was executed
+        QoreExternalProgramContextHelper pch(&xsink, pgm);
+        if (!xsink) {
+            ReferenceHolder<QoreListNode> args(new QoreListNode(autoTypeInfo), &xsink);
+            obj->ref();
+            args->push(obj, &xsink);
+            ValueHolder rv(callback->execValue(*args, &xsink), &xsink);
+        }
+        cleanup(&xsink);
+    }
+    // exceptions thrown by the callback cannot be returned to the caller
+    if (xsink) {
+        xsink.handleExceptions();
+    }
+}
+
+void QoreXmlSecAsyncTask::cancel(ExceptionSink* xsink) {
+    cleanup(xsink);
+}
+
+void QoreXmlSecAsyncTask::cleanup(ExceptionSink* xsink) {
+    if (ids) {
+        ids->deref(xsink);
+        ids = nullptr;
+    }
+    if (callback) {
+        callback->deref(xsink);
+        callback = nullptr;
+    }
+    if (obj) {
+        obj->deref(xsink);
+        obj = nullptr;
+    }
+    if (res) {
+        res->deref(xsink);
+        res = nullptr;
+    }
+    if (pgm) {
+        pgm->deref(xsink);
+        pgm = nullptr;
+    }
+}
+
+QoreXmlSecWorkerPool::QoreXmlSecWorkerPool() {
+    max_threads = std::thread::hardware_concurrency();
+    if (!max_threads) {
+        max_threads = 1;
+    }
+}
+
+int QoreXmlSecWorkerPool::submit(QoreXmlSecAsyncTask* task, ExceptionSink* xsink) {
+    {
+        AutoLocker al(this);
+        if (stopped) {
+            xsink->raiseException("XMLSEC-ASYNC-ERROR", "the xmlsec worker pool has been shut down");
+        } else {
+            queue.push_back(task);
+            // the task will be executed by a thread that is not executing a task or when a thread becomes available
+            if (queue.size() <= (threads - active - callbacks) || (threads - callbacks) >= max_threads) {
+                return 0;
+            }
+            ++threads;
+            if (q_start_thread(xsink, workerThread, this) != -1) {
+                return 0;
+            }
+            --threads;
+            if (threads) {
+                // the task will be executed by an existing thread
+                xsink->clear();
+                return 0;
+            }
+            queue.pop_back();
+        }
+    }
+
+    assert(*xsink);
+    task->cancel(xsink);
+    delete task;
+    return -1;
+}
+
+int QoreXmlSecWorkerPool::setMaxThreads(int64 max, ExceptionSink* xsink) {
+    if (max < 1) {
+        xsink->raiseException("XMLSEC-ASYNC-ERROR", "invalid maximum thread count " QLLD "; expecting a value >= 1",
+            max);
+        return -1;
+    }
+
+    AutoLocker al(this);
+    max_threads = (unsigned)max;
+    return 0;
+}
+
+QoreHashNode* QoreXmlSecWorkerPool::getInfo() {
+    AutoLocker al(this);
+    QoreHashNode* h = new QoreHashNode(autoTypeInfo);
+    h->setKeyValue("max_threads", (int64)max_threads, nullptr);
+    h->setKeyValue("threads", (int64)threads, nullptr);
+    h->setKeyValue("active", (int64)active, nullptr);
+    h->setKeyValue("callbacks", (int64)callbacks, nullptr);
+    h->setKeyValue("queued", (int64)queue.size(), nullptr);
+    return h;
+}
+
+void QoreXmlSecWorkerPool::shutdown() {
+    AutoLocker al(this);
+    stopped = true;
+    while (threads) {
+        exit_cond.wait(this);
+    }
+}
+
+void QoreXmlSecWorkerPool::workerThread(ExceptionSink* xsink, void* arg) {
+    reinterpret_cast<QoreXmlSecWorkerPool*>(arg)->run();
+}
+
+void QoreXmlSecWorkerPool::run() {
+    AutoLocker al(this);
+    // exit when no work remains or if the maximum thread count has been reduced
+    while (!queue.empty() && (threads - callbacks) <= max_threads) {
+        QoreXmlSecAsyncTask* task = queue.front();
+        queue.pop_front();
+        ++active;
+
+        bool call;
+        {
+            AutoUnlocker aul(this);
+            call = task->run();
+            if (!call) {
+                delete task;
+            }
+        }
+        --active;
+
+        if (call) {
+            // the callback is executed outside of the maximum thread count, so that it can wait for other
+            // asynchronous operations without blocking the pool
+            ++callbacks;
+            {
+                AutoUnlocker aul(this);
+                task->runCallback();
+                delete task;
+            }
+            --callbacks;
+        }
+    }
+
+    if (!--threads) {
+        exit_cond.broadcast();
+    }
+}
@@ -0,0 +1,143 @@
+/*
+    Qore Programming Language
+
+    Copyright 2003 - 2021 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_XMLSEC_QOREXMLSECWORKERPOOL_H
+
+#define _QORE_XMLSEC_QOREXMLSECWORKERPOOL_H
+
+#include "QC_XmlSec.h"
+#include "QC_XmlSecAsyncResult.h"
+
+#include <deque>
+
+//! an xmlsec operation to be executed in a worker thread; holds references to all of its arguments
+class QoreXmlSecAsyncTask {
+public:
+    enum op_e {
+        OP_SIGN,
+        OP_VERIFY,
+        OP_ENCRYPT,
+        OP_DECRYPT,
+    };
+
+    //! takes over the references to k and m; references all other arguments
+    DLLLOCAL QoreXmlSecAsyncTask(op_e o, QoreXmlSecKey* k, QoreXmlSecKeyManager* m, const QoreStringNode* s,
+            const QoreStringNode* t = nullptr, const BinaryNode* b = nullptr, const QoreListNode* l = nullptr)
+            : op(o), key(k), mgr(m), str(s ? s->stringRefSelf() : nullptr), tmpl(t ? t->stringRefSelf() : nullptr),
+            bin(b ? (BinaryNode*)b->refSelf() : nullptr), ids(l ? l->copy() : nullptr),
+            res(new QoreXmlSecAsyncResult), pgm(getProgram()) {
+        pgm->ref();
+    }
+
+    DLLLOCAL ~QoreXmlSecAsyncTask() {
+        assert(!ids);
+        assert(!callback);
+        assert(!obj);
+        assert(!res);
+        assert(!pgm);
+    }
+
+    //! returns a new object for the result of the task
+    DLLLOCAL QoreObject* getResultObject() {
+        res->ref();
+        return new QoreObject(QC_XMLSECASYNCRESULT, getProgram(), res);
+    }
+
+    //! sets the callback to call with the result object when the operation completes
+    DLLLOCAL void setCallback(const ResolvedCallReferenceNode* cb, QoreObject* o) {
+        callback = cb->refRefSelf();
+        o->ref();
+        obj = o;
+    }
+
+    //! executes the operation and sets the result; returns true if runCallback() must be called
+    /** the operation is executed in the context of the program that submitted the task
+    */
+    DLLLOCAL bool run();
+
+    //! calls the callback in the context of the program that submitted the task; must be called after run()
+    DLLLOCAL void runCallback();
+
+    //! cleans up a task that will not be executed
+    DLLLOCAL void cancel(ExceptionSink* xsink);
+
+private:
+    op_e op;
+    SimpleRefHolder<QoreXmlSecKey> key;
+    SimpleRefHolder<QoreXmlSecKeyManager> mgr;
+    SimpleRefHolder<QoreStringNode> str;
+    SimpleRefHolder<QoreStringNode> tmpl;
+    SimpleRefHolder<BinaryNode> bin;
+    // verification IDs; a copy of the list passed, dereferenced with cleanup()
+    QoreListNode* ids;
+    QoreXmlSecAsyncResult* res;
+    ResolvedCallReferenceNode* callback = nullptr;
+    QoreObject* obj = nullptr;
+    // the program that submitted the task
+    QoreProgram* pgm;
+
+    DLLLOCAL QoreValue exec(ExceptionSink* xsink);
+
+    DLLLOCAL void cleanup(ExceptionSink* xsink);
+};
+
+//! a pool of worker threads for asynchronous xmlsec operations
+/** threads are started on demand up to the maximum and exit as soon as no tasks are queued; tasks are executed in
+    the context of the program that submitted them, but a thread is counted in the thread count of the program that
+    started it and executes the tasks of all programs until the queue is empty, so that program cannot terminate
+    until the tasks queued by other programs have been executed
+*/
+class QoreXmlSecWorkerPool : public QoreThreadLock {
+public:
+    DLLLOCAL QoreXmlSecWorkerPool();
+
+    //! queues the task for execution; takes ownership of the task in any case
+    DLLLOCAL int submit(QoreXmlSecAsyncTask* task, ExceptionSink* xsink);
+
+    DLLLOCAL int setMaxThreads(int64 max, ExceptionSink* xsink);
+
+    DLLLOCAL QoreHashNode* getInfo();
+
+    //! executes any queued tasks and waits for all worker threads to exit
+    DLLLOCAL void shutdown();
+
+private:
+    typedef std::deque<QoreXmlSecAsyncTask*> task_queue_t;
+
+    task_queue_t queue;
+    // signaled when the last worker thread exits
+    QoreCondition exit_cond;
+    unsigned max_threads;
+    unsigned threads = 0;
+    // the number of threads executing an operation
+    unsigned active = 0;
+    // the number of threads executing a callback; these do not count towards the maximum, as callbacks may wait
+    // for the results of other asynchronous operations
+    unsigned callbacks = 0;
+    bool stopped = false;
+
+    DLLLOCAL static void workerThread(ExceptionSink* xsink, void* arg);
+
+    DLLLOCAL void run();
+};
+
+DLLLOCAL extern QoreXmlSecWorkerPool worker_pool;
+
+#endif
@@ -30,3 +30,8 @@
 #define XMLSEC_KEYDATA_RAWX509CERTID 7
 
 extern xmlSecKeyDataId xmlsec_get_keydata_id(int i);
+
+// initializes the xmlsec library and crypto engine on first use; returns -1 and raises an exception on error
+DLLLOCAL extern int xmlsec_check_init(ExceptionSink* xsink);
+// returns the time taken to initialize the crypto engine in microseconds or -1 if not yet initialized
+DLLLOCAL extern int64 xmlsec_get_init_time();
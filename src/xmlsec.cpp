@@ -25,8 +25,12 @@
 #include "QC_XmlSec.h"
 #include "QC_XmlSecKey.h"
 #include "QC_XmlSecKeyManager.h"
+#include "QoreXmlSecKeyCache.h"
+#include "QC_XmlSecAsyncResult.h"
+#include "QoreXmlSecWorkerPool.h"
 
-#include <map>
+#include <atomic>
+#include <chrono>
 
 QoreStringNode* xmlsec_module_init();
 void xmlsec_module_ns_init(QoreNamespace *rns, QoreNamespace *qns);
@@ -45,17 +49,6 @@ DLLEXPORT qore_module_ns_init_t qore_module_ns_init = xmlsec_module_ns_init;
 DLLEXPORT qore_module_delete_t qore_module_delete = xmlsec_module_delete;
 DLLEXPORT qore_license_t qore_module_license = QL_LGPL;
 
-typedef std::map<int, xmlSecKeyDataId> key_data_map_t;
-static key_data_map_t key_data_map = {
-    {XMLSEC_KEYDATA_AESID, xmlSecKeyDataAesId},
-    {XMLSEC_KEYDATA_DESID, xmlSecKeyDataDesId},
-    {XMLSEC_KEYDATA_DSAID, xmlSecKeyDataDsaId},
-    {XMLSEC_KEYDATA_HMACID, xmlSecKeyDataHmacId},
-    {XMLSEC_KEYDATA_RSAID, xmlSecKeyDataRsaId},
-    {XMLSEC_KEYDATA_X509ID, xmlSecKeyDataX509Id},
-    {XMLSEC_KEYDATA_RAWX509CERTID, xmlSecKeyDataRawX509CertId},
-};
-
 QoreNamespace XmlSec_NS("Qore::XmlSec");
 qore_type_t NT_XMLSECKEYDATAID = -1;
 qore_type_t NT_XMLSECKEYDATAFORMAT = -1;
@@ -67,33 +60,47 @@ qore_type_t NT_XMLSECKEYDATAFORMAT = -1;
 DLLLOCAL QoreThreadLock big_lock;
 #endif
 
+// cache for keys loaded from memory
+DLLLOCAL QoreXmlSecKeyCache key_cache;
+
+// worker threads for asynchronous operations
+DLLLOCAL QoreXmlSecWorkerPool worker_pool;
+
+// crypto engine initialization is deferred until the first key or key manager is created
+static QoreThreadLock crypto_init_lock;
+static std::atomic<bool> crypto_init_done(false);
+static bool crypto_init_failed = false;
+static QoreString crypto_init_err;
+static int64 crypto_init_us = -1;
+// 1 = xmlsec, 2 = crypto library, 3 = xmlsec-crypto library initialized
+static int crypto_init_stage = 0;
+
+// the key data IDs must be resolved after the crypto engine has been initialized, as with dynamic crypto library
+// loading they are looked up in the loaded xmlsec-crypto library
 xmlSecKeyDataId xmlsec_get_keydata_id(int id) {
-    key_data_map_t::const_iterator i = key_data_map.find(id);
-    return i != key_data_map.end() ? i->second : nullptr;
-};
+    switch (id) {
+        case XMLSEC_KEYDATA_AESID: return xmlSecKeyDataAesId;
+        case XMLSEC_KEYDATA_DESID: return xmlSecKeyDataDesId;
+        case XMLSEC_KEYDATA_DSAID: return xmlSecKeyDataDsaId;
+        case XMLSEC_KEYDATA_HMACID: return xmlSecKeyDataHmacId;
+        case XMLSEC_KEYDATA_RSAID: return xmlSecKeyDataRsaId;
+        case XMLSEC_KEYDATA_X509ID: return xmlSecKeyDataX509Id;
+        case XMLSEC_KEYDATA_RAWX509CERTID: return xmlSecKeyDataRawX509CertId;
+    }
+    return nullptr;
+}
 
 // xmlsec library error callback function
 static void qore_xmlSecErrorsCallback(const char *file, int line, const char *func, const char *errorObject, const char *errorSubject, int reason, const char *msg) {
     printd(0, "xmlsec error: %s: %s: %s\n", errorObject, errorSubject, msg);
 }
 
-DLLLOCAL void preinitXmlSecKeyClass();
-DLLLOCAL void preinitXmlSecKeyManagerClass();
-
-QoreStringNode* xmlsec_module_init() {
-    xmlLoadExtDtdDefaultValue = XML_DETECT_IDS | XML_COMPLETE_ATTRS;
-    xmlSubstituteEntitiesDefault(1);
-#ifndef XMLSEC_NO_XSLT
-    xmlIndentTreeOutput = 0;
-#endif // XMLSEC_NO_XSLT
-
+// initializes the xmlsec library and the crypto engine; returns an error string on failure
+static QoreStringNode* xmlsec_crypto_init_intern() {
     // Init xmlsec library
     if (xmlSecInit() < 0)
         return new QoreStringNode("xmlsec initialization failed");
-
-    // Check loaded library version
-    if (xmlSecCheckVersion() != 1)
-        return new QoreStringNode("xmlsec library version is not compatible");
+    crypto_init_stage = 1;
 
     /* Load default crypto engine if we are supporting dynamic
      * loading for xmlsec-crypto libraries. Use the crypto library
@@ -121,22 +128,73 @@ QoreStringNode* xmlsec_module_init() {
     if (xmlSecCryptoAppInit(NULL) < 0) {
         return new QoreStringNode("crypto initialization failed");
     }
+    crypto_init_stage = 2;
 
     // Init xmlsec-crypto library
     if (xmlSecCryptoInit() < 0) {
         return new QoreStringNode("xmlsec-crypto initialization failed");
     }
+    crypto_init_stage = 3;
 
     // set error callback function
     xmlSecErrorsSetCallback(qore_xmlSecErrorsCallback);
 
+    return nullptr;
+}
+
+int xmlsec_check_init(ExceptionSink* xsink) {
+    if (!crypto_init_done.load(std::memory_order_acquire)) {
+        AutoLocker al(crypto_init_lock);
+        if (!crypto_init_done.load(std::memory_order_relaxed)) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            SimpleRefHolder<QoreStringNode> err(xmlsec_crypto_init_intern());
+            crypto_init_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            if (err) {
+                crypto_init_failed = true;
+                crypto_init_err.concat(*err);
+            }
+            printd(1, "xmlsec crypto engine initialization %s in " QLLD " us\n",
+                crypto_init_failed ? "failed" : "completed", crypto_init_us);
+            crypto_init_done.store(true, std::memory_order_release);
+        }
+    }
+
+    if (crypto_init_failed) {
+        xsink->raiseException("XMLSEC-INIT-ERROR", "%s", crypto_init_err.c_str());
+        return -1;
+    }
+    return 0;
+}
+
+int64 xmlsec_get_init_time() {
+    return crypto_init_done.load(std::memory_order_acquire) ? crypto_init_us : -1;
+}
+
+DLLLOCAL void preinitXmlSecKeyClass();
+DLLLOCAL void preinitXmlSecKeyManagerClass();
+DLLLOCAL void preinitXmlSecAsyncResultClass();
+
+QoreStringNode* xmlsec_module_init() {
+    xmlLoadExtDtdDefaultValue = XML_DETECT_IDS | XML_COMPLETE_ATTRS;
+    xmlSubstituteEntitiesDefault(1);
+#ifndef XMLSEC_NO_XSLT
+    xmlIndentTreeOutput = 0;
+#endif // XMLSEC_NO_XSLT
+
+    // Check loaded library version
+    if (xmlSecCheckVersion() != 1)
+        return new QoreStringNode("xmlsec library version is not compatible");
+
     // setup XmlSec namespace
     // add classes
     preinitXmlSecKeyClass();
     preinitXmlSecKeyManagerClass();
+    preinitXmlSecAsyncResultClass();
     XmlSec_NS.addSystemClass(initXmlSecClass(XmlSec_NS));
     XmlSec_NS.addSystemClass(initXmlSecKeyClass(XmlSec_NS));
     XmlSec_NS.addSystemClass(initXmlSecKeyManagerClass(XmlSec_NS));
+    XmlSec_NS.addSystemClass(initXmlSecAsyncResultClass(XmlSec_NS));
 
     return nullptr;
 }
@@ -146,14 +204,23 @@ void xmlsec_module_ns_init(QoreNamespace* rns, QoreNamespace* qns) {
 }
 
 void xmlsec_module_delete() {
+    // finish any queued asynchronous operations
+    worker_pool.shutdown();
+
+    // free cached keys before the crypto library is shut down
+    key_cache.clear();
+
     // Shutdown xmlsec-crypto library
-    xmlSecCryptoShutdown();
+    if (crypto_init_stage > 2)
+        xmlSecCryptoShutdown();
 
     // Shutdown crypto library
-    xmlSecCryptoAppShutdown();
+    if (crypto_init_stage > 1)
+        xmlSecCryptoAppShutdown();
 
     // Shutdown xmlsec library
-    xmlSecShutdown();
+    if (crypto_init_stage > 0)
+        xmlSecShutdown();
 
     // Shutdown libxslt/libxml
 #ifndef XMLSEC_NO_XSLT